@@ -4,6 +4,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "spi_timing.h"
+#include "spi_observer.h"
+
+// APB cycles the state machine spends between frames (RX_ACTIVE -> IDLE -> TX_ACTIVE)
+#define SPI_HW_TURNAROUND_APB  2U
 
 // SPI Register Map (simulating STM32-like SPI)
 typedef struct {
@@ -43,26 +48,34 @@ typedef struct {
     State_Tracker tracker;
     
     // Simulation
-    uint64_t clock_cycle;
-    uint32_t baud_rate;
+    uint64_t clock_cycle;       // Host-bus (APB) cycles
+    uint32_t baud_rate;         // Effective SCK rate derived from CR1 BR[2:0]
     bool simulation_mode;
     
-    // FIFOs (simulating hardware buffers)
-    uint8_t tx_fifo[16];
-    uint8_t rx_fifo[16];
+    // FIFOs (simulating hardware buffers, 8- or 16-bit frames per CR1 DFF)
+    uint16_t tx_fifo[16];
+    uint16_t rx_fifo[16];
     uint8_t tx_ptr;
     uint8_t rx_ptr;
     uint8_t tx_level;
     uint8_t rx_level;
     
+    // Timing (SCK domain derived from APB via prescaler)
+    SPI_Timing_Config timing;
+    uint64_t sck_cycle;
+    uint32_t frame_cycles_left;
+    uint32_t gap_cycles_left;
+    uint16_t shift_reg;
+    
     // External connections (for co-simulation)
-    void (*mosi_callback)(uint8_t data);
-    void (*miso_callback)(uint8_t data);
     void (*ss_callback)(bool active);
+    uint8_t (*slave_respond)(void* ctx, uint8_t mosi);  // MISO source, NULL = inverted echo
+    void* slave_context;
     
-    // Verification hooks
-    void (*on_state_change)(void* ctx, SPI_State old, SPI_State new);
-    void* callback_context;
+    // Verification hooks (batched, see spi_observer.h)
+#if SPI_OBSERVERS
+    SPI_Observer_Hub* observers;
+#endif
     
     // Statistics
     uint32_t bytes_transmitted;
@@ -80,6 +93,10 @@ void spi_hw_clock_cycle(SPI_HW_Model* model);
 void spi_hw_reset(SPI_HW_Model* model);
 void spi_hw_write_reg(SPI_HW_Model* model, uint32_t offset, uint32_t value);
 uint32_t spi_hw_read_reg(SPI_HW_Model* model, uint32_t offset);
+void spi_hw_set_clock(SPI_HW_Model* model, uint32_t apb_clock_hz, uint16_t inter_frame_gap_sck);
+#if SPI_OBSERVERS
+void spi_hw_attach_observers(SPI_HW_Model* model, SPI_Observer_Hub* hub);
+#endif
 
 // State space analysis
 void spi_print_state_analysis(SPI_HW_Model* model);
@@ -0,0 +1,109 @@
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+#include "spi_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPI_BUS_MAX_DEVICES   8
+#define SPI_BUS_QUEUE_DEPTH   16
+#define SPI_BUS_WFQ_SCALE     1024U   // Fixed-point scale for fair-queuing tags
+
+// Slave device attached to one NSS line
+typedef struct {
+    const char* name;
+    uint8_t nss_line;
+    uint8_t priority;               // Higher is served first (priority policy)
+    uint8_t weight;                 // Bandwidth share (weighted fair policy)
+    uint32_t baud_rate;             // 0 = bus default rate
+    uint8_t (*respond)(void* ctx, uint8_t mosi);  // MISO byte for each MOSI byte
+    void* respond_context;
+} SPI_Device_Config;
+
+// Queued transaction
+typedef struct {
+    uint8_t* tx_data;
+    uint8_t* rx_data;
+    uint32_t length;
+    uint64_t enqueue_cycle;
+    uint64_t seq;
+    uint64_t finish_tag;
+} SPI_Bus_Transaction;
+
+// Per-device accounting (APB cycles)
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t cs_switches;
+    uint64_t busy_cycles;           // NSS assert to NSS release
+    uint64_t wire_cycles;           // Driver transfer time with NSS asserted
+    uint64_t switch_overhead_cycles;// CS setup/hold and reconfiguration
+    uint64_t queue_wait_cycles;
+    uint64_t max_queue_wait;
+} SPI_Device_Stats;
+
+typedef struct {
+    SPI_Device_Config config;
+    SPI_Device_Stats stats;
+    SPI_Bus_Transaction queue[SPI_BUS_QUEUE_DEPTH];
+    uint8_t queue_head;
+    uint8_t queue_level;
+    uint64_t last_finish_tag;
+} SPI_Device;
+
+typedef struct SPI_Bus SPI_Bus;
+
+// Scheduling policy: returns a device with a non-empty queue, or -1 if all queues are empty
+typedef int (*SPI_Bus_Policy)(const SPI_Bus* bus);
+
+// Bus timing
+typedef struct {
+    uint16_t cs_setup_sck;          // NSS assert to first SCK edge
+    uint16_t cs_hold_sck;           // Last SCK edge to NSS release
+    uint32_t cs_switch_apb;         // Extra host-bus cycles when changing device
+    uint32_t timeout_ms;
+} SPI_Bus_Config;
+
+extern const SPI_Bus_Config default_bus_config;
+
+struct SPI_Bus {
+    SPI_Driver driver;
+    SPI_Bus_Config config;
+    SPI_Bus_Policy policy;
+    SPI_Device devices[SPI_BUS_MAX_DEVICES];
+    uint8_t device_count;
+    int active_device;              // Device whose NSS is asserted, -1 if none
+    int last_device;
+    uint8_t nss_active;             // Bitmask of asserted NSS lines
+    uint64_t next_seq;
+    uint64_t virtual_time;
+    uint64_t start_cycle;
+    uint32_t base_baud_rate;
+    void (*nss_callback)(void* ctx, uint8_t line, bool active);
+    void* nss_context;
+};
+
+// Public API
+SPI_Error spi_bus_init(SPI_Bus* bus, uint32_t base_addr, SPI_Config* spi_config,
+                       const SPI_Bus_Config* bus_config);
+SPI_Error spi_bus_deinit(SPI_Bus* bus);
+SPI_Error spi_bus_attach(SPI_Bus* bus, const SPI_Device_Config* config, uint8_t* device_id);
+void spi_bus_set_policy(SPI_Bus* bus, SPI_Bus_Policy policy);
+SPI_Error spi_bus_submit(SPI_Bus* bus, uint8_t device_id, uint8_t* tx_data,
+                         uint8_t* rx_data, uint32_t length);
+SPI_Error spi_bus_step(SPI_Bus* bus);
+SPI_Error spi_bus_run(SPI_Bus* bus);
+uint32_t spi_bus_pending(const SPI_Bus* bus);
+
+// Built-in policies
+int spi_bus_policy_fifo(const SPI_Bus* bus);
+int spi_bus_policy_priority(const SPI_Bus* bus);
+int spi_bus_policy_weighted_fair(const SPI_Bus* bus);
+
+// Statistics
+float spi_bus_device_bandwidth(const SPI_Bus* bus, uint8_t device_id);
+float spi_bus_utilization(const SPI_Bus* bus);
+void spi_bus_print_stats(const SPI_Bus* bus);
+
+#endif // SPI_BUS_H
@@ -24,6 +24,8 @@ typedef struct {
     uint8_t bit_order;
     bool software_slave_management;
     bool master_mode;
+    uint32_t apb_clock_hz;          // Host-bus clock feeding the prescaler (0 = default)
+    uint16_t inter_frame_gap_sck;   // Idle SCK periods between frames
 } SPI_Config;
 
 // External declaration of default config (defined in spi_driver.c)
@@ -39,9 +41,6 @@ typedef struct {
     uint32_t total_bytes;
     uint64_t total_latency_cycles;
     uint32_t error_count;
-    void (*pre_transfer_hook)(void* ctx);
-    void (*post_transfer_hook)(void* ctx, SPI_Error result);
-    void* hook_context;
 } SPI_Driver;
 
 // Public API
@@ -55,5 +54,6 @@ SPI_Error spi_driver_set_baudrate(SPI_Driver* driver, uint32_t baud_rate);
 SPI_Error spi_driver_get_status(SPI_Driver* driver);
 void spi_driver_print_stats(SPI_Driver* driver);
 float spi_driver_get_efficiency(SPI_Driver* driver);
+SPI_Error spi_driver_project(SPI_Driver* driver, uint32_t length, SPI_Timing_Projection* out);
 
 #endif // SPI_DRIVER_H
\ No newline at end of file
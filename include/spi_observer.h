@@ -0,0 +1,95 @@
+#ifndef SPI_OBSERVER_H
+#define SPI_OBSERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Build with -DSPI_OBSERVERS=0 to compile every observer site out of the model and driver
+#ifndef SPI_OBSERVERS
+#define SPI_OBSERVERS 1
+#endif
+
+#define SPI_OBSERVER_BATCH            32
+#define SPI_OBSERVER_MAX_SUBSCRIBERS  4
+
+typedef enum {
+    SPI_EVT_STATE_CHANGE = 0,   // arg = old state, value = new state
+    SPI_EVT_MOSI,               // value = byte shifted out
+    SPI_EVT_MISO,               // value = byte shifted in
+    SPI_EVT_TRANSFER_BEGIN,     // value = length
+    SPI_EVT_TRANSFER_END,       // value = SPI_Error result
+    SPI_EVT_COUNT
+} SPI_Event_Type;
+
+typedef struct {
+    uint64_t cycle;
+    uint16_t type;
+    uint16_t arg;
+    uint32_t value;
+} SPI_Event;
+
+// Receives one batch of events of a single type
+typedef void (*SPI_Observer_Fn)(void* ctx, const SPI_Event* events, uint32_t count);
+
+typedef struct {
+    SPI_Observer_Fn fn;
+    void* ctx;
+} SPI_Subscriber;
+
+typedef struct {
+    SPI_Event events[SPI_OBSERVER_BATCH];
+    uint32_t count;
+} SPI_Event_Batch;
+
+// Subscribers and pending batches; attach to a model to start collecting
+typedef struct {
+    SPI_Subscriber subscribers[SPI_EVT_COUNT][SPI_OBSERVER_MAX_SUBSCRIBERS];
+    uint8_t subscriber_count[SPI_EVT_COUNT];
+    uint32_t mask;                  // Event types with at least one subscriber
+    SPI_Event_Batch batches[SPI_EVT_COUNT];
+    uint64_t quantum_cycles;        // Deliver at least this often (checked every model cycle), 0 = batch/transfer boundaries only
+    uint64_t last_flush_cycle;
+    uint32_t deliveries;
+} SPI_Observer_Hub;
+
+// Public API
+void spi_observer_init(SPI_Observer_Hub* hub, uint64_t quantum_cycles);
+bool spi_observer_subscribe(SPI_Observer_Hub* hub, SPI_Event_Type type, SPI_Observer_Fn fn, void* ctx);
+void spi_observer_deliver(SPI_Observer_Hub* hub, SPI_Event_Type type);
+void spi_observer_flush(SPI_Observer_Hub* hub, uint64_t cycle);
+
+// Buffer one event; delivery happens only when a batch fills or the quantum elapses
+static inline void spi_observer_emit(SPI_Observer_Hub* hub, SPI_Event_Type type,
+                                     uint16_t arg, uint32_t value, uint64_t cycle) {
+    SPI_Event_Batch* batch = &hub->batches[type];
+    SPI_Event* evt = &batch->events[batch->count++];
+    evt->cycle = cycle;
+    evt->type = (uint16_t)type;
+    evt->arg = arg;
+    evt->value = value;
+    if (hub->quantum_cycles && cycle - hub->last_flush_cycle >= hub->quantum_cycles)
+        spi_observer_flush(hub, cycle);
+    else if (batch->count == SPI_OBSERVER_BATCH)
+        spi_observer_deliver(hub, type);
+}
+
+#if SPI_OBSERVERS
+#define SPI_OBSERVE(hub, type, arg, value, cycle) \
+    do { \
+        if ((hub) && ((hub)->mask & (1U << (type)))) \
+            spi_observer_emit((hub), (type), (uint16_t)(arg), (uint32_t)(value), (cycle)); \
+    } while (0)
+#define SPI_OBSERVE_FLUSH(hub, cycle) \
+    do { if (hub) spi_observer_flush((hub), (cycle)); } while (0)
+#define SPI_OBSERVE_QUANTUM(hub, cycle) \
+    do { \
+        if ((hub) && (hub)->quantum_cycles && (cycle) - (hub)->last_flush_cycle >= (hub)->quantum_cycles) \
+            spi_observer_flush((hub), (cycle)); \
+    } while (0)
+#else
+#define SPI_OBSERVE(hub, type, arg, value, cycle) do { } while (0)
+#define SPI_OBSERVE_FLUSH(hub, cycle) do { } while (0)
+#define SPI_OBSERVE_QUANTUM(hub, cycle) do { } while (0)
+#endif
+
+#endif // SPI_OBSERVER_H
@@ -0,0 +1,47 @@
+#ifndef SPI_TIMING_H
+#define SPI_TIMING_H
+
+#include <stdint.h>
+
+// Default host-bus (APB) clock feeding the SPI peripheral
+#define SPI_TIMING_DEFAULT_APB_HZ   16000000U
+#define SPI_TIMING_DEFAULT_GAP_SCK  1U
+#define SPI_TIMING_MAX_PRESCALER    7U
+
+// Timing configuration. The APB clock drives register access and the model
+// clock; SCK = APB / 2^(prescaler + 1) as selected by CR1 BR[2:0].
+typedef struct {
+    uint32_t apb_clock_hz;
+    uint8_t prescaler;              // CR1 BR[2:0]
+    uint8_t frame_bits;             // 8 or 16 (CR1 DFF)
+    uint16_t inter_frame_gap_sck;   // Idle SCK periods between frames
+    uint32_t turnaround_apb;        // Minimum host-bus cycles between frames; the gap overlaps it
+} SPI_Timing_Config;
+
+// Analytic transfer projection
+typedef struct {
+    uint32_t sck_hz;
+    uint32_t apb_cycles_per_sck;
+    uint32_t apb_cycles_per_frame;  // Shift + max(gap, turnaround)
+    uint32_t frames;
+    uint64_t total_apb_cycles;
+    float latency_us;
+    float throughput_bps;           // Payload bytes per second
+    float wire_efficiency;          // % of transfer time SCK carries payload
+} SPI_Timing_Projection;
+
+// Public API
+void spi_timing_default(SPI_Timing_Config* cfg);
+uint8_t spi_timing_prescaler_for_baud(uint32_t apb_clock_hz, uint32_t baud_rate);
+uint32_t spi_timing_apb_cycles_per_sck(const SPI_Timing_Config* cfg);
+uint32_t spi_timing_sck_hz(const SPI_Timing_Config* cfg);
+uint32_t spi_timing_frame_cycles(const SPI_Timing_Config* cfg);
+uint32_t spi_timing_gap_cycles(const SPI_Timing_Config* cfg);
+uint32_t spi_timing_spacing_cycles(const SPI_Timing_Config* cfg);
+void spi_timing_project(const SPI_Timing_Config* cfg, uint32_t payload_bytes,
+                        SPI_Timing_Projection* out);
+
+// Debug
+void spi_timing_print_projection(const SPI_Timing_Config* cfg, const SPI_Timing_Projection* proj);
+
+#endif // SPI_TIMING_H
@@ -1,6 +1,7 @@
 #include "hw_model.h"
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 
 static inline void reg_bit_set(volatile uint32_t* reg, uint8_t bit) {
     *reg |= (1U << bit);
@@ -14,14 +15,26 @@ static inline bool reg_bit_is_set(uint32_t reg, uint8_t bit) {
     return (reg & (1U << bit)) != 0;
 }
 
+static inline uint16_t frame_mask(SPI_HW_Model* model) {
+    return model->timing.frame_bits == 16 ? 0xFFFF : 0x00FF;
+}
+
+// MISO for one frame; 16-bit frames ask the slave for each byte, low byte first
+static uint16_t shift_in_frame(SPI_HW_Model* model) {
+    if (!model->slave_respond) return model->shift_reg ^ frame_mask(model);
+    uint16_t rx = model->slave_respond(model->slave_context, (uint8_t)model->shift_reg);
+    if (model->timing.frame_bits == 16)
+        rx |= (uint16_t)model->slave_respond(model->slave_context, (uint8_t)(model->shift_reg >> 8)) << 8;
+    return rx;
+}
+
 static void record_transition(SPI_HW_Model* model, SPI_State new_state) {
     if (model->current_state != new_state) {
-        model->tracker.transitions[model->current_state][new_state]++;
+        SPI_State old_state = model->current_state;
+        model->tracker.transitions[old_state][new_state]++;
         model->current_state = new_state;
         model->tracker.visit_count[new_state]++;
-        if (model->on_state_change) {
-            model->on_state_change(model->callback_context, model->current_state, new_state);
-        }
+        SPI_OBSERVE(model->observers, SPI_EVT_STATE_CHANGE, old_state, new_state, model->clock_cycle);
     }
 }
 
@@ -33,7 +46,9 @@ void spi_hw_init(SPI_HW_Model* model, uint32_t base_addr) {
     model->regs.SR = 0x0002;
     model->current_state = SPI_STATE_IDLE;
     model->clock_cycle = 0;
-    model->baud_rate = 1000000;
+    spi_timing_default(&model->timing);
+    model->timing.turnaround_apb = SPI_HW_TURNAROUND_APB;
+    model->baud_rate = spi_timing_sck_hz(&model->timing);
     model->tx_ptr = model->rx_ptr = model->tx_level = model->rx_level = 0;
     model->simulation_mode = true;
     printf("[HW_MODEL] SPI initialized at 0x%08X\n", base_addr);
@@ -42,30 +57,48 @@ void spi_hw_init(SPI_HW_Model* model, uint32_t base_addr) {
 void spi_hw_clock_cycle(SPI_HW_Model* model) {
     if (!model) return;
     model->clock_cycle++;
+    SPI_OBSERVE_QUANTUM(model->observers, model->clock_cycle);
     if (!reg_bit_is_set(model->regs.CR1, 6)) {
         if (model->current_state != SPI_STATE_IDLE) record_transition(model, SPI_STATE_IDLE);
         return;
     }
 
+    uint32_t per_sck = spi_timing_apb_cycles_per_sck(&model->timing);
+    bool gap_elapsed = model->gap_cycles_left == 0;
+    if (!gap_elapsed) model->gap_cycles_left--;
+
     switch (model->current_state) {
         case SPI_STATE_IDLE:
-            if (model->tx_level > 0 || reg_bit_is_set(model->regs.SR, 1))
+            if (model->tx_level > 0)
                 record_transition(model, SPI_STATE_TX_ACTIVE);
             break;
         case SPI_STATE_TX_ACTIVE:
-            if (model->tx_level > 0) {
-                uint8_t data = model->tx_fifo[model->tx_ptr];
+            // Load the shifter once the inter-frame gap has elapsed
+            if (model->frame_cycles_left == 0 && gap_elapsed && model->tx_level > 0) {
+                model->shift_reg = model->tx_fifo[model->tx_ptr];
                 model->tx_ptr = (model->tx_ptr + 1) % 16;
                 model->tx_level--;
-                if (model->mosi_callback) model->mosi_callback(data);
-                uint8_t rx_data = data ^ 0xFF;
-                if (model->rx_level < 16) {
-                    model->rx_fifo[(model->rx_ptr + model->rx_level) % 16] = rx_data;
-                    model->rx_level++;
+                model->frame_cycles_left = spi_timing_frame_cycles(&model->timing);
+                reg_bit_set(&model->regs.SR, 7);
+                SPI_OBSERVE(model->observers, SPI_EVT_MOSI, 0, model->shift_reg, model->clock_cycle);
+            }
+            if (model->frame_cycles_left > 0) {
+                model->frame_cycles_left--;
+                if (model->frame_cycles_left % per_sck == 0) model->sck_cycle++;
+                if (model->frame_cycles_left == 0) {
+                    uint16_t rx_data = shift_in_frame(model);
+                    SPI_OBSERVE(model->observers, SPI_EVT_MISO, 0, rx_data, model->clock_cycle);
+                    if (model->rx_level < 16) {
+                        model->rx_fifo[(model->rx_ptr + model->rx_level) % 16] = rx_data;
+                        model->rx_level++;
+                        reg_bit_set(&model->regs.SR, 0);
+                    }
+                    model->bytes_transmitted += model->timing.frame_bits / 8;
+                    model->gap_cycles_left = spi_timing_gap_cycles(&model->timing);
+                    reg_bit_clear(&model->regs.SR, 7);
                 }
-                model->bytes_transmitted++;
             }
-            if (model->tx_level == 0 && !reg_bit_is_set(model->regs.SR, 1)) {
+            if (model->frame_cycles_left == 0 && model->tx_level == 0) {
                 record_transition(model, model->rx_level > 0 ? SPI_STATE_RX_ACTIVE : SPI_STATE_IDLE);
             }
             break;
@@ -101,15 +134,19 @@ void spi_hw_write_reg(SPI_HW_Model* model, uint32_t offset, uint32_t value) {
         case 0x0C:
             reg = &model->regs.DR;
             if (model->tx_level < 16) {
-                model->tx_fifo[(model->tx_ptr + model->tx_level) % 16] = (uint8_t)value;
+                model->tx_fifo[(model->tx_ptr + model->tx_level) % 16] = (uint16_t)(value & frame_mask(model));
                 model->tx_level++;
-                model->bytes_transmitted++;
             }
             break;
         default: return;
     }
     if (reg) {
         *reg = value;
+        if (offset == 0x00) {
+            model->timing.prescaler = (value >> 3) & 0x7;
+            model->timing.frame_bits = reg_bit_is_set(value, 11) ? 16 : 8;
+            model->baud_rate = spi_timing_sck_hz(&model->timing);
+        }
         for (int i = 0; i < 32; i++) {
             if (value & (1U << i))
                 model->reg_write_coverage[i / 8] |= (1 << (i % 8));
@@ -129,7 +166,7 @@ uint32_t spi_hw_read_reg(SPI_HW_Model* model, uint32_t offset) {
                 value = model->rx_fifo[model->rx_ptr];
                 model->rx_ptr = (model->rx_ptr + 1) % 16;
                 model->rx_level--;
-                model->bytes_received++;
+                model->bytes_received += model->timing.frame_bits / 8;
                 if (model->rx_level == 0) reg_bit_clear(&model->regs.SR, 0);
             }
             break;
@@ -141,6 +178,22 @@ uint32_t spi_hw_read_reg(SPI_HW_Model* model, uint32_t offset) {
     return value;
 }
 
+void spi_hw_set_clock(SPI_HW_Model* model, uint32_t apb_clock_hz, uint16_t inter_frame_gap_sck) {
+    if (!model || apb_clock_hz == 0) return;
+    model->timing.apb_clock_hz = apb_clock_hz;
+    model->timing.inter_frame_gap_sck = inter_frame_gap_sck;
+    model->baud_rate = spi_timing_sck_hz(&model->timing);
+}
+
+#if SPI_OBSERVERS
+void spi_hw_attach_observers(SPI_HW_Model* model, SPI_Observer_Hub* hub) {
+    if (!model) return;
+    SPI_OBSERVE_FLUSH(model->observers, model->clock_cycle);
+    model->observers = hub;
+    if (hub) hub->last_flush_cycle = model->clock_cycle;
+}
+#endif
+
 float spi_calculate_state_coverage(SPI_HW_Model* model) {
     if (!model) return 0.0f;
     uint32_t visited = 0;
@@ -153,7 +206,8 @@ void spi_print_state_analysis(SPI_HW_Model* model) {
 
     printf("\n=== SPI State Space Analysis ===\n");
     printf("Current State: %d\n", model->current_state);
-    printf("Clock Cycles: %I64u\n", model->clock_cycle);
+    printf("Clock Cycles: %" PRIu64 "\n", model->clock_cycle);
+    printf("SCK Cycles: %" PRIu64 " (%u Hz)\n", model->sck_cycle, model->baud_rate);
     printf("State Coverage: %.1f%%\n", spi_calculate_state_coverage(model));
 
     const char* state_names[] = {
@@ -188,7 +242,21 @@ void spi_print_state_analysis(SPI_HW_Model* model) {
 
 void spi_hw_reset(SPI_HW_Model* model) {
     if (!model) return;
+    // Clock tree and attached slaves are board wiring, not peripheral state
+    SPI_Timing_Config timing = model->timing;
+    uint8_t (*slave_respond)(void* ctx, uint8_t mosi) = model->slave_respond;
+    void* slave_context = model->slave_context;
+#if SPI_OBSERVERS
+    SPI_Observer_Hub* observers = model->observers;
+    spi_hw_attach_observers(model, NULL);
+#endif
     spi_hw_init(model, 0);
+    spi_hw_set_clock(model, timing.apb_clock_hz, timing.inter_frame_gap_sck);
+    model->slave_respond = slave_respond;
+    model->slave_context = slave_context;
+#if SPI_OBSERVERS
+    spi_hw_attach_observers(model, observers);
+#endif
     printf("[HW_MODEL] SPI hardware reset\n");
 }
 
@@ -17,6 +17,9 @@ void test_error_conditions(void);
 void test_state_space_coverage(void);
 void test_performance_benchmark(void);
 void test_concurrent_access(void);
+void test_timing_projection(void);
+void test_multi_slave_bus(void);
+void test_observer_batching(void);
 
 // Simple test runner
 #define RUN_TEST(test_func, test_name) \
@@ -40,6 +43,9 @@ int main() {
     RUN_TEST(test_state_space_coverage, "3. State Space Coverage Test");
     RUN_TEST(test_performance_benchmark, "4. Performance Benchmark");
     RUN_TEST(test_concurrent_access, "5. Concurrent Access Test");
+    RUN_TEST(test_timing_projection, "6. Timing Projection Test");
+    RUN_TEST(test_multi_slave_bus, "7. Multi-Slave Bus Test");
+    RUN_TEST(test_observer_batching, "8. Observer Batching Test");
     
     printf("\n========================================\n");
     printf("              TEST SUMMARY\n");
@@ -0,0 +1,246 @@
+#include "spi_bus.h"
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+const SPI_Bus_Config default_bus_config = {
+    .cs_setup_sck = 1,
+    .cs_hold_sck = 1,
+    .cs_switch_apb = 0,
+    .timeout_ms = 100
+};
+
+static void bus_idle(SPI_Bus* bus, uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; i++) spi_hw_clock_cycle(bus->driver.hw_model);
+}
+
+static void bus_set_nss(SPI_Bus* bus, int device, bool active) {
+    uint8_t line = bus->devices[device].config.nss_line;
+    if (active) bus->nss_active |= (uint8_t)(1U << line);
+    else bus->nss_active &= (uint8_t)~(1U << line);
+    bus->active_device = active ? device : -1;
+    if (bus->nss_callback) bus->nss_callback(bus->nss_context, line, active);
+    if (bus->driver.hw_model->ss_callback) bus->driver.hw_model->ss_callback(bus->nss_active != 0);
+}
+
+// MISO router: only the selected slave drives the line, otherwise it floats high
+static uint8_t bus_route_miso(void* ctx, uint8_t mosi) {
+    SPI_Bus* bus = (SPI_Bus*)ctx;
+    if (bus->active_device < 0) return 0xFF;
+    SPI_Device_Config* dev = &bus->devices[bus->active_device].config;
+    return dev->respond ? dev->respond(dev->respond_context, mosi) : 0xFF;
+}
+
+SPI_Error spi_bus_init(SPI_Bus* bus, uint32_t base_addr, SPI_Config* spi_config,
+                       const SPI_Bus_Config* bus_config) {
+    if (!bus) return SPI_ERR_INVALID_ARG;
+    memset(bus, 0, sizeof(SPI_Bus));
+    SPI_Error err = spi_driver_init(&bus->driver, base_addr, spi_config);
+    if (err != SPI_OK) return err;
+    bus->config = bus_config ? *bus_config : default_bus_config;
+    bus->policy = spi_bus_policy_fifo;
+    bus->active_device = -1;
+    bus->last_device = -1;
+    bus->driver.hw_model->slave_respond = bus_route_miso;
+    bus->driver.hw_model->slave_context = bus;
+    bus->start_cycle = bus->driver.hw_model->clock_cycle;
+    bus->base_baud_rate = bus->driver.config.baud_rate;
+    return SPI_OK;
+}
+
+SPI_Error spi_bus_deinit(SPI_Bus* bus) {
+    if (!bus) return SPI_ERR_INVALID_ARG;
+    return spi_driver_deinit(&bus->driver);
+}
+
+SPI_Error spi_bus_attach(SPI_Bus* bus, const SPI_Device_Config* config, uint8_t* device_id) {
+    if (!bus || !config || !bus->driver.initialized) return SPI_ERR_INVALID_ARG;
+    if (bus->device_count >= SPI_BUS_MAX_DEVICES || config->nss_line >= 8) return SPI_ERR_INVALID_ARG;
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        if (bus->devices[i].config.nss_line == config->nss_line) return SPI_ERR_INVALID_ARG;
+    }
+    SPI_Device* dev = &bus->devices[bus->device_count];
+    memset(dev, 0, sizeof(SPI_Device));
+    dev->config = *config;
+    if (dev->config.weight == 0) dev->config.weight = 1;
+    if (device_id) *device_id = bus->device_count;
+    bus->device_count++;
+    return SPI_OK;
+}
+
+void spi_bus_set_policy(SPI_Bus* bus, SPI_Bus_Policy policy) {
+    if (!bus) return;
+    bus->policy = policy ? policy : spi_bus_policy_fifo;
+}
+
+SPI_Error spi_bus_submit(SPI_Bus* bus, uint8_t device_id, uint8_t* tx_data,
+                         uint8_t* rx_data, uint32_t length) {
+    if (!bus || device_id >= bus->device_count || !tx_data || length == 0) return SPI_ERR_INVALID_ARG;
+    SPI_Device* dev = &bus->devices[device_id];
+    if (dev->queue_level >= SPI_BUS_QUEUE_DEPTH) return SPI_ERR_BUSY;
+
+    SPI_Bus_Transaction* t = &dev->queue[(dev->queue_head + dev->queue_level) % SPI_BUS_QUEUE_DEPTH];
+    t->tx_data = tx_data;
+    t->rx_data = rx_data;
+    t->length = length;
+    t->enqueue_cycle = bus->driver.hw_model->clock_cycle;
+    t->seq = bus->next_seq++;
+
+    // Self-clocked fair queuing: tag = max(virtual time, previous tag) + length / weight
+    uint64_t start = dev->last_finish_tag > bus->virtual_time ? dev->last_finish_tag : bus->virtual_time;
+    t->finish_tag = start + (uint64_t)length * SPI_BUS_WFQ_SCALE / dev->config.weight;
+    dev->last_finish_tag = t->finish_tag;
+    dev->queue_level++;
+    return SPI_OK;
+}
+
+uint32_t spi_bus_pending(const SPI_Bus* bus) {
+    if (!bus) return 0;
+    uint32_t pending = 0;
+    for (uint8_t i = 0; i < bus->device_count; i++) pending += bus->devices[i].queue_level;
+    return pending;
+}
+
+static const SPI_Bus_Transaction* queue_head(const SPI_Device* dev) {
+    return dev->queue_level ? &dev->queue[dev->queue_head] : NULL;
+}
+
+int spi_bus_policy_fifo(const SPI_Bus* bus) {
+    int best = -1;
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        const SPI_Bus_Transaction* t = queue_head(&bus->devices[i]);
+        if (t && (best < 0 || t->seq < queue_head(&bus->devices[best])->seq)) best = i;
+    }
+    return best;
+}
+
+int spi_bus_policy_priority(const SPI_Bus* bus) {
+    int best = -1;
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        const SPI_Bus_Transaction* t = queue_head(&bus->devices[i]);
+        if (!t) continue;
+        if (best < 0) { best = i; continue; }
+        uint8_t prio = bus->devices[i].config.priority;
+        uint8_t best_prio = bus->devices[best].config.priority;
+        if (prio > best_prio || (prio == best_prio && t->seq < queue_head(&bus->devices[best])->seq))
+            best = i;
+    }
+    return best;
+}
+
+int spi_bus_policy_weighted_fair(const SPI_Bus* bus) {
+    int best = -1;
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        const SPI_Bus_Transaction* t = queue_head(&bus->devices[i]);
+        if (!t) continue;
+        if (best < 0) { best = i; continue; }
+        const SPI_Bus_Transaction* b = queue_head(&bus->devices[best]);
+        if (t->finish_tag < b->finish_tag || (t->finish_tag == b->finish_tag && t->seq < b->seq))
+            best = i;
+    }
+    return best;
+}
+
+SPI_Error spi_bus_step(SPI_Bus* bus) {
+    if (!bus || !bus->driver.initialized) return SPI_ERR_INVALID_ARG;
+    int id = bus->policy(bus);
+    if (id < 0 && spi_bus_pending(bus) == 0) return SPI_OK;
+    // Reject picks that are out of range or would dequeue from an empty queue
+    if (id < 0 || id >= bus->device_count || bus->devices[id].queue_level == 0) return SPI_ERR_INVALID_ARG;
+
+    SPI_Device* dev = &bus->devices[id];
+    SPI_Bus_Transaction t = dev->queue[dev->queue_head];
+    dev->queue_head = (dev->queue_head + 1) % SPI_BUS_QUEUE_DEPTH;
+    dev->queue_level--;
+
+    SPI_HW_Model* hw = bus->driver.hw_model;
+    uint64_t start = hw->clock_cycle;
+    uint64_t wait = start - t.enqueue_cycle;
+    dev->stats.queue_wait_cycles += wait;
+    if (wait > dev->stats.max_queue_wait) dev->stats.max_queue_wait = wait;
+
+    // Reconfigure for the new device before it is selected
+    if (id != bus->last_device) {
+        dev->stats.cs_switches++;
+        uint32_t baud = dev->config.baud_rate ? dev->config.baud_rate : bus->base_baud_rate;
+        if (baud != bus->driver.config.baud_rate) spi_driver_set_baudrate(&bus->driver, baud);
+        bus_idle(bus, bus->config.cs_switch_apb);
+    }
+
+    uint32_t per_sck = spi_timing_apb_cycles_per_sck(&hw->timing);
+    bus_set_nss(bus, id, true);
+    uint64_t nss_start = hw->clock_cycle;
+    bus_idle(bus, (uint64_t)bus->config.cs_setup_sck * per_sck);
+    uint64_t xfer_start = hw->clock_cycle;
+    SPI_Error err = spi_driver_transfer(&bus->driver, t.tx_data, t.rx_data, t.length,
+                                        bus->config.timeout_ms);
+    uint64_t xfer_end = hw->clock_cycle;
+    bus_idle(bus, (uint64_t)bus->config.cs_hold_sck * per_sck);
+    bus_set_nss(bus, id, false);
+    uint64_t end = hw->clock_cycle;
+
+    dev->stats.transactions++;
+    dev->stats.bytes += t.length;
+    dev->stats.busy_cycles += end - nss_start;
+    dev->stats.wire_cycles += xfer_end - xfer_start;
+    dev->stats.switch_overhead_cycles += (end - start) - (xfer_end - xfer_start);
+    if (err != SPI_OK) dev->stats.errors++;
+    if (t.finish_tag > bus->virtual_time) bus->virtual_time = t.finish_tag;
+    bus->last_device = id;
+    return err;
+}
+
+SPI_Error spi_bus_run(SPI_Bus* bus) {
+    if (!bus) return SPI_ERR_INVALID_ARG;
+    SPI_Error result = SPI_OK;
+    while (spi_bus_pending(bus) > 0) {
+        SPI_Error err = spi_bus_step(bus);
+        if (err != SPI_OK) result = err;
+        // A bad policy pick dequeues nothing, so retrying would never finish
+        if (err == SPI_ERR_INVALID_ARG) break;
+    }
+    return result;
+}
+
+// Payload bytes per second over the bus lifetime
+float spi_bus_device_bandwidth(const SPI_Bus* bus, uint8_t device_id) {
+    if (!bus || device_id >= bus->device_count) return 0.0f;
+    uint64_t elapsed = bus->driver.hw_model->clock_cycle - bus->start_cycle;
+    if (elapsed == 0) return 0.0f;
+    return (float)((double)bus->devices[device_id].stats.bytes *
+                   bus->driver.hw_model->timing.apb_clock_hz / elapsed);
+}
+
+// Share of elapsed time spent moving data; CS switches and setup/hold count as lost bandwidth
+float spi_bus_utilization(const SPI_Bus* bus) {
+    if (!bus) return 0.0f;
+    uint64_t elapsed = bus->driver.hw_model->clock_cycle - bus->start_cycle;
+    if (elapsed == 0) return 0.0f;
+    uint64_t wire = 0;
+    for (uint8_t i = 0; i < bus->device_count; i++) wire += bus->devices[i].stats.wire_cycles;
+    return (float)wire / (float)elapsed * 100.0f;
+}
+
+void spi_bus_print_stats(const SPI_Bus* bus) {
+    if (!bus) return;
+    printf("\n=== SPI Bus Statistics ===\n");
+    printf("Devices:            %u\n", bus->device_count);
+    printf("Utilization:        %.1f%%\n", spi_bus_utilization(bus));
+    printf("%-12s %4s %6s %8s %10s %10s %10s %8s %10s\n",
+           "Device", "NSS", "Xfers", "Bytes", "KB/s", "AvgWait", "MaxWait", "Switches", "Overhead");
+    for (uint8_t i = 0; i < bus->device_count; i++) {
+        const SPI_Device* dev = &bus->devices[i];
+        float avg_wait = dev->stats.transactions
+            ? (float)dev->stats.queue_wait_cycles / dev->stats.transactions : 0.0f;
+        printf("%-12s %4u %6u %8u %10.1f %10.1f %10" PRIu64 " %8u %10" PRIu64 "\n",
+               dev->config.name ? dev->config.name : "?",
+               dev->config.nss_line,
+               dev->stats.transactions,
+               dev->stats.bytes,
+               spi_bus_device_bandwidth(bus, i) / 1000.0f,
+               avg_wait,
+               dev->stats.max_queue_wait,
+               dev->stats.cs_switches,
+               dev->stats.switch_overhead_cycles);
+    }
+}
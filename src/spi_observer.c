@@ -0,0 +1,37 @@
+#include "spi_observer.h"
+#include <string.h>
+
+void spi_observer_init(SPI_Observer_Hub* hub, uint64_t quantum_cycles) {
+    if (!hub) return;
+    memset(hub, 0, sizeof(SPI_Observer_Hub));
+    hub->quantum_cycles = quantum_cycles;
+}
+
+bool spi_observer_subscribe(SPI_Observer_Hub* hub, SPI_Event_Type type, SPI_Observer_Fn fn, void* ctx) {
+    if (!hub || !fn || type >= SPI_EVT_COUNT) return false;
+    if (hub->subscriber_count[type] >= SPI_OBSERVER_MAX_SUBSCRIBERS) return false;
+    SPI_Subscriber* sub = &hub->subscribers[type][hub->subscriber_count[type]++];
+    sub->fn = fn;
+    sub->ctx = ctx;
+    hub->mask |= (1U << type);
+    return true;
+}
+
+// Hand one type's pending batch to all of its subscribers
+void spi_observer_deliver(SPI_Observer_Hub* hub, SPI_Event_Type type) {
+    if (!hub || type >= SPI_EVT_COUNT) return;
+    SPI_Event_Batch* batch = &hub->batches[type];
+    if (batch->count == 0) return;
+    for (uint8_t i = 0; i < hub->subscriber_count[type]; i++) {
+        SPI_Subscriber* sub = &hub->subscribers[type][i];
+        sub->fn(sub->ctx, batch->events, batch->count);
+        hub->deliveries++;
+    }
+    batch->count = 0;
+}
+
+void spi_observer_flush(SPI_Observer_Hub* hub, uint64_t cycle) {
+    if (!hub) return;
+    for (int type = 0; type < SPI_EVT_COUNT; type++) spi_observer_deliver(hub, (SPI_Event_Type)type);
+    hub->last_flush_cycle = cycle;
+}
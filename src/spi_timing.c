@@ -0,0 +1,90 @@
+#include "spi_timing.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+void spi_timing_default(SPI_Timing_Config* cfg) {
+    if (!cfg) return;
+    memset(cfg, 0, sizeof(SPI_Timing_Config));
+    cfg->apb_clock_hz = SPI_TIMING_DEFAULT_APB_HZ;
+    cfg->prescaler = 0;
+    cfg->frame_bits = 8;
+    cfg->inter_frame_gap_sck = SPI_TIMING_DEFAULT_GAP_SCK;
+    cfg->turnaround_apb = 0;
+}
+
+// Smallest divider whose SCK does not exceed the requested baud rate
+uint8_t spi_timing_prescaler_for_baud(uint32_t apb_clock_hz, uint32_t baud_rate) {
+    if (baud_rate == 0) return SPI_TIMING_MAX_PRESCALER;
+    uint8_t br = 0;
+    while (br < SPI_TIMING_MAX_PRESCALER && (apb_clock_hz >> (br + 1)) > baud_rate) br++;
+    return br;
+}
+
+uint32_t spi_timing_apb_cycles_per_sck(const SPI_Timing_Config* cfg) {
+    if (!cfg) return 0;
+    uint8_t br = cfg->prescaler > SPI_TIMING_MAX_PRESCALER ? SPI_TIMING_MAX_PRESCALER : cfg->prescaler;
+    return 1U << (br + 1);
+}
+
+uint32_t spi_timing_sck_hz(const SPI_Timing_Config* cfg) {
+    if (!cfg) return 0;
+    return cfg->apb_clock_hz / spi_timing_apb_cycles_per_sck(cfg);
+}
+
+// APB cycles the shifter is busy with one frame
+uint32_t spi_timing_frame_cycles(const SPI_Timing_Config* cfg) {
+    if (!cfg) return 0;
+    uint32_t bits = cfg->frame_bits ? cfg->frame_bits : 8;
+    return bits * spi_timing_apb_cycles_per_sck(cfg);
+}
+
+// APB cycles the bus idles between back-to-back frames
+uint32_t spi_timing_gap_cycles(const SPI_Timing_Config* cfg) {
+    if (!cfg) return 0;
+    return cfg->inter_frame_gap_sck * spi_timing_apb_cycles_per_sck(cfg);
+}
+
+// APB cycles from the end of one frame to the start of the next
+uint32_t spi_timing_spacing_cycles(const SPI_Timing_Config* cfg) {
+    if (!cfg) return 0;
+    uint32_t gap = spi_timing_gap_cycles(cfg);
+    return gap > cfg->turnaround_apb ? gap : cfg->turnaround_apb;
+}
+
+void spi_timing_project(const SPI_Timing_Config* cfg, uint32_t payload_bytes,
+                        SPI_Timing_Projection* out) {
+    if (!cfg || !out) return;
+    memset(out, 0, sizeof(SPI_Timing_Projection));
+    uint32_t bits = cfg->frame_bits ? cfg->frame_bits : 8;
+    uint32_t frame = spi_timing_frame_cycles(cfg);
+    uint32_t spacing = spi_timing_spacing_cycles(cfg);
+
+    out->sck_hz = spi_timing_sck_hz(cfg);
+    out->apb_cycles_per_sck = spi_timing_apb_cycles_per_sck(cfg);
+    out->apb_cycles_per_frame = frame + spacing;
+    out->frames = (uint32_t)(((uint64_t)payload_bytes * 8 + bits - 1) / bits);
+    if (out->frames == 0 || cfg->apb_clock_hz == 0) return;
+
+    // No spacing trails the last frame
+    out->total_apb_cycles = (uint64_t)out->frames * out->apb_cycles_per_frame - spacing;
+    out->latency_us = (float)((double)out->total_apb_cycles * 1000000.0 / cfg->apb_clock_hz);
+    out->throughput_bps = (float)((double)payload_bytes * cfg->apb_clock_hz / out->total_apb_cycles);
+    out->wire_efficiency = (float)((double)payload_bytes * 8 * out->apb_cycles_per_sck
+                                   / out->total_apb_cycles * 100.0);
+}
+
+void spi_timing_print_projection(const SPI_Timing_Config* cfg, const SPI_Timing_Projection* proj) {
+    if (!cfg || !proj) return;
+    printf("\n=== SPI Timing Projection ===\n");
+    printf("APB Clock:          %u Hz\n", cfg->apb_clock_hz);
+    printf("SCK:                %u Hz (BR=%u, /%u)\n", proj->sck_hz, cfg->prescaler, proj->apb_cycles_per_sck);
+    printf("Frame:              %u bits, gap %u SCK, turnaround %u APB\n",
+           cfg->frame_bits, cfg->inter_frame_gap_sck, cfg->turnaround_apb);
+    printf("Cycles/Frame:       %u APB\n", proj->apb_cycles_per_frame);
+    printf("Frames:             %u\n", proj->frames);
+    printf("Total Cycles:       %" PRIu64 " APB\n", proj->total_apb_cycles);
+    printf("Latency:            %.2f us\n", proj->latency_us);
+    printf("Throughput:         %.1f KB/s\n", proj->throughput_bps / 1000.0f);
+    printf("Wire Efficiency:    %.1f%%\n", proj->wire_efficiency);
+}
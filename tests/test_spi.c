@@ -1,8 +1,10 @@
 #include "spi_driver.h"
+#include "spi_bus.h"
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <inttypes.h>
 
 void test_basic_transfer(void) {
     printf("\n=== Test 1: Basic Transfer ===\n");
@@ -26,6 +28,9 @@ void test_basic_transfer(void) {
     }
 #pragma GCC diagnostic pop
 
+    assert(driver.hw_model->bytes_transmitted == 8);
+    assert(driver.hw_model->bytes_received == 8);
+
     spi_driver_print_stats(&driver);
     spi_print_state_analysis(driver.hw_model);
     printf("✓ Basic transfer test PASSED\n");
@@ -43,7 +48,9 @@ void test_error_conditions(void) {
     err = spi_driver_transfer(&driver, data, NULL, 0, 100);
     assert(err == SPI_ERR_INVALID_ARG);
 
+    // Stall the peripheral: TXE cleared and SPE off so it never recovers
     driver.hw_model->regs.SR &= ~(1U << 1);
+    driver.hw_model->regs.CR1 &= ~(1U << 6);
     err = spi_driver_transfer(&driver, data, NULL, 1, 1);
     assert(err == SPI_ERR_TIMEOUT);
 
@@ -96,17 +103,19 @@ void test_performance_benchmark(void) {
         assert(err == SPI_OK);
 
         uint64_t cycles = driver.hw_model->clock_cycle - start;
-        float bps = (float)size * 1000000.0f / (cycles ? cycles : 1);
-        float eff = (bps * 8.0f) / config.baud_rate * 100.0f;
+        float bps = (float)size * driver.hw_model->timing.apb_clock_hz / (cycles ? cycles : 1);
+        float eff = (bps * 8.0f) / driver.hw_model->baud_rate * 100.0f;
 
-        printf("  Size: %4u bytes, Cycles: %6I64u, Throughput: %6.1f KB/s, Efficiency: %5.1f%%\n",
-               size, cycles, bps / 1000.0f, eff);
+        SPI_Timing_Projection proj;
+        spi_driver_project(&driver, size, &proj);
+        printf("  Size: %4u bytes, Cycles: %6" PRIu64 " (projected %6" PRIu64 "), Throughput: %6.1f KB/s, Efficiency: %5.1f%%\n",
+               size, cycles, proj.total_apb_cycles, bps / 1000.0f, eff);
 
         free(tx_data);
         free(rx_data);
     }
 
-    printf("\nOverall Efficiency: %.1f%%\n", spi_driver_get_efficiency(&driver));
+    printf("\nDriver Efficiency vs Projection: %.1f%%\n", spi_driver_get_efficiency(&driver));
     if (spi_driver_get_efficiency(&driver) > 80.0f) {
         printf("✓ Performance benchmark PASSED\n");
     } else {
@@ -132,4 +141,322 @@ void test_concurrent_access(void) {
     if (!race) printf("✓ No data races detected\n");
     else printf("✗ Potential data race detected!\n");
     printf("Concurrent access test completed\n");
-}
\ No newline at end of file
+}
+
+void test_timing_projection(void) {
+    printf("\n=== Test 6: Timing Projection ===\n");
+
+    // Prescaler selection: SCK never exceeds the requested baud rate
+    assert(spi_timing_prescaler_for_baud(16000000, 8000000) == 0);
+    assert(spi_timing_prescaler_for_baud(16000000, 1000000) == 3);
+    assert(spi_timing_prescaler_for_baud(16000000, 600000) == 4);
+    assert(spi_timing_prescaler_for_baud(16000000, 1) == SPI_TIMING_MAX_PRESCALER);
+
+    SPI_Timing_Config cfg;
+    spi_timing_default(&cfg);
+    cfg.prescaler = 3;
+    cfg.inter_frame_gap_sck = 2;
+    SPI_Timing_Projection proj;
+    spi_timing_project(&cfg, 4, &proj);
+    assert(proj.sck_hz == 1000000);
+    assert(proj.apb_cycles_per_frame == 8 * 16 + 2 * 16);
+    assert(proj.total_apb_cycles == 4 * 8 * 16 + 3 * 2 * 16);
+    spi_timing_print_projection(&cfg, &proj);
+
+    cfg.frame_bits = 16;
+    spi_timing_project(&cfg, 4, &proj);
+    assert(proj.frames == 2);  // Two payload bytes per frame
+
+    // The prescaler must govern the simulated transfer time. Simulation may exceed the
+    // projection only by the first IDLE -> TX_ACTIVE cycle.
+    uint32_t bauds[] = {4000000, 1000000, 250000};
+    uint64_t prev = 0;
+    for (int b = 0; b < 3; b++) {
+        SPI_Driver driver;
+        SPI_Config config = default_config;
+        config.baud_rate = bauds[b];
+        spi_driver_init(&driver, 0x40013000, &config);
+
+        uint8_t tx[64], rx[64];
+        for (int i = 0; i < 64; i++) tx[i] = (uint8_t)i;
+        uint64_t start = driver.hw_model->clock_cycle;
+        SPI_Error err = spi_driver_transfer(&driver, tx, rx, 64, 100);
+        assert(err == SPI_OK);
+        uint64_t cycles = driver.hw_model->clock_cycle - start;
+
+        spi_driver_project(&driver, 64, &proj);
+        printf("  SCK %7u Hz: simulated %6" PRIu64 ", projected %6" PRIu64 " cycles\n",
+               driver.hw_model->baud_rate, cycles, proj.total_apb_cycles);
+        assert(cycles >= proj.total_apb_cycles);
+        assert(cycles <= proj.total_apb_cycles + 1);
+        assert(cycles > prev);
+        prev = cycles;
+        spi_driver_deinit(&driver);
+    }
+
+    // 16-bit frames move two bytes each, matching the projection; odd tails are padded
+    uint32_t lengths[] = {8, 64, 7};
+    for (int l = 0; l < 3; l++) {
+        SPI_Driver driver;
+        SPI_Config config = default_config;
+        config.data_size = 16;
+        spi_driver_init(&driver, 0x40013000, &config);
+
+        uint8_t tx[64], rx[64] = {0};
+        for (int i = 0; i < 64; i++) tx[i] = (uint8_t)(i * 7);
+        uint64_t start = driver.hw_model->clock_cycle;
+        SPI_Error err = spi_driver_transfer(&driver, tx, rx, lengths[l], 100);
+        assert(err == SPI_OK);
+        uint64_t cycles = driver.hw_model->clock_cycle - start;
+        for (uint32_t i = 0; i < lengths[l]; i++) assert((rx[i] ^ tx[i]) == 0xFF);
+        assert(driver.hw_model->bytes_transmitted == (lengths[l] + 1) / 2 * 2);  // Padded tail frame counts in full
+
+        spi_driver_project(&driver, lengths[l], &proj);
+        printf("  16-bit, %2u bytes: simulated %6" PRIu64 ", projected %6" PRIu64 " cycles, %u frames\n",
+               lengths[l], cycles, proj.total_apb_cycles, proj.frames);
+        assert(proj.frames == (lengths[l] + 1) / 2);
+        assert(cycles >= proj.total_apb_cycles);
+        assert(cycles <= proj.total_apb_cycles + 1);
+        assert(spi_driver_get_efficiency(&driver) > 95.0f);
+        spi_driver_deinit(&driver);
+    }
+
+    // Back-to-back frames at prescaler 0: the state-machine turnaround, not the gap, spaces them
+    uint8_t widths[] = {8, 16};
+    for (int w = 0; w < 2; w++) {
+        SPI_Driver driver;
+        SPI_Config config = default_config;
+        config.baud_rate = 8000000;
+        config.data_size = widths[w];
+        config.inter_frame_gap_sck = 0;
+        spi_driver_init(&driver, 0x40013000, &config);
+        assert(driver.hw_model->timing.prescaler == 0);
+
+        uint8_t tx[64], rx[64];
+        for (int i = 0; i < 64; i++) tx[i] = (uint8_t)i;
+        uint64_t start = driver.hw_model->clock_cycle;
+        SPI_Error err = spi_driver_transfer(&driver, tx, rx, 64, 100);
+        assert(err == SPI_OK);
+        uint64_t cycles = driver.hw_model->clock_cycle - start;
+
+        spi_driver_project(&driver, 64, &proj);
+        printf("  %2u-bit, gap 0: simulated %6" PRIu64 ", projected %6" PRIu64 " cycles\n",
+               widths[w], cycles, proj.total_apb_cycles);
+        assert(cycles >= proj.total_apb_cycles);
+        assert(cycles <= proj.total_apb_cycles + 1);
+        spi_driver_deinit(&driver);
+    }
+    printf("✓ Timing projection test PASSED\n");
+}
+
+typedef struct {
+    uint8_t id;
+    uint8_t* log;
+    uint32_t* log_len;
+} Test_Slave;
+
+// Each slave answers with its own id so routing is observable on MISO
+static uint8_t test_slave_respond(void* ctx, uint8_t mosi) {
+    Test_Slave* slave = (Test_Slave*)ctx;
+    if (mosi == 0xA0) slave->log[(*slave->log_len)++] = slave->id;
+    return (uint8_t)(0x10 * (slave->id + 1));
+}
+
+static int test_policy_none(const SPI_Bus* bus) { (void)bus; return -1; }
+static int test_policy_out_of_range(const SPI_Bus* bus) { return bus->device_count; }
+static int test_policy_empty(const SPI_Bus* bus) { (void)bus; return 2; }
+
+void test_multi_slave_bus(void) {
+    printf("\n=== Test 7: Multi-Slave Bus ===\n");
+    static uint8_t tx[3][16][4];
+    static uint8_t rx[3][16][4];
+    uint8_t order[64];
+    uint32_t order_len = 0;
+    Test_Slave slaves[3] = {{0, order, &order_len}, {1, order, &order_len}, {2, order, &order_len}};
+    const char* names[3] = {"flash", "sensor_hub", "display"};
+
+    SPI_Bus bus;
+    SPI_Bus_Config bus_config = default_bus_config;
+    bus_config.cs_switch_apb = 8;
+    SPI_Error err = spi_bus_init(&bus, 0x40013000, NULL, &bus_config);
+    assert(err == SPI_OK);
+    uint8_t ids[3];
+    for (uint8_t d = 0; d < 3; d++) {
+        SPI_Device_Config dev = {
+            .name = names[d], .nss_line = d, .priority = d, .weight = (uint8_t)(d == 0 ? 4 : 1),
+            .baud_rate = d == 0 ? 4000000 : 0,
+            .respond = test_slave_respond, .respond_context = &slaves[d]
+        };
+        assert(spi_bus_attach(&bus, &dev, &ids[d]) == SPI_OK);
+    }
+    SPI_Device_Config dup = {.name = "dup", .nss_line = 1};
+    assert(spi_bus_attach(&bus, &dup, NULL) == SPI_ERR_INVALID_ARG);
+
+    for (int d = 0; d < 3; d++)
+        for (int i = 0; i < 16; i++) {
+            tx[d][i][0] = 0xA0;
+            tx[d][i][1] = tx[d][i][2] = tx[d][i][3] = (uint8_t)i;
+        }
+
+    // FIFO: submission order, interleaved across devices, routed by NSS
+    for (int i = 0; i < 2; i++)
+        for (uint8_t d = 0; d < 3; d++) spi_bus_submit(&bus, ids[d], tx[d][i], rx[d][i], 4);
+    assert(spi_bus_run(&bus) == SPI_OK);
+    assert(order_len == 6);
+    for (uint32_t i = 0; i < 6; i++) assert(order[i] == i % 3);
+    for (int d = 0; d < 3; d++) assert(rx[d][0][2] == 0x10 * (d + 1));
+    assert(bus.devices[0].stats.cs_switches == 2);
+    assert(bus.devices[0].stats.switch_overhead_cycles > 0);
+    assert(bus.nss_active == 0);
+
+    // Priority: display (2) drains before sensor hub (1) before flash (0)
+    order_len = 0;
+    spi_bus_set_policy(&bus, spi_bus_policy_priority);
+    for (int i = 0; i < 2; i++)
+        for (uint8_t d = 0; d < 3; d++) spi_bus_submit(&bus, ids[d], tx[d][i], rx[d][i], 4);
+    assert(spi_bus_run(&bus) == SPI_OK);
+    uint8_t expect_prio[6] = {2, 2, 1, 1, 0, 0};
+    for (int i = 0; i < 6; i++) assert(order[i] == expect_prio[i]);
+
+    // Weighted fair: flash (weight 4) gets 4 slots per sensor/display slot
+    order_len = 0;
+    spi_bus_set_policy(&bus, spi_bus_policy_weighted_fair);
+    for (int i = 0; i < 12; i++) spi_bus_submit(&bus, ids[0], tx[0][i], rx[0][i], 4);
+    for (int i = 0; i < 3; i++) {
+        spi_bus_submit(&bus, ids[1], tx[1][i], rx[1][i], 4);
+        spi_bus_submit(&bus, ids[2], tx[2][i], rx[2][i], 4);
+    }
+    assert(spi_bus_run(&bus) == SPI_OK);
+    assert(order_len == 18);
+    uint32_t flash_in_first_six = 0;
+    for (int i = 0; i < 6; i++) if (order[i] == 0) flash_in_first_six++;
+    assert(flash_in_first_six == 4);
+
+    spi_bus_print_stats(&bus);
+    assert(bus.devices[0].stats.bytes == (2 + 2 + 12) * 4);
+    assert(bus.devices[1].stats.max_queue_wait > 0);
+    assert(spi_bus_device_bandwidth(&bus, ids[0]) > spi_bus_device_bandwidth(&bus, ids[1]));
+
+    // Elapsed time splits into wire time and CS overhead; only wire time is utilization.
+    // Busy (NSS asserted) excludes the reconfiguration done before NSS goes low.
+    uint64_t wire = 0, overhead = 0;
+    for (int d = 0; d < 3; d++) {
+        wire += bus.devices[d].stats.wire_cycles;
+        overhead += bus.devices[d].stats.switch_overhead_cycles;
+        assert(bus.devices[d].stats.busy_cycles < bus.devices[d].stats.wire_cycles +
+                                                  bus.devices[d].stats.switch_overhead_cycles);
+    }
+    assert(wire + overhead == bus.driver.hw_model->clock_cycle - bus.start_cycle);
+    float util = spi_bus_utilization(&bus);
+    assert(overhead > 0 && util < 100.0f && util > 50.0f);
+
+    // A misbehaving policy stops the run instead of spinning or corrupting a queue
+    SPI_Bus_Policy bad_policies[3] = {test_policy_none, test_policy_out_of_range, test_policy_empty};
+    for (int p = 0; p < 3; p++) {
+        spi_bus_set_policy(&bus, bad_policies[p]);
+        spi_bus_submit(&bus, ids[0], tx[0][0], rx[0][0], 4);
+        assert(spi_bus_run(&bus) == SPI_ERR_INVALID_ARG);
+        assert(spi_bus_pending(&bus) == 1);
+        assert(bus.devices[2].queue_level == 0);
+        spi_bus_set_policy(&bus, spi_bus_policy_fifo);
+        assert(spi_bus_run(&bus) == SPI_OK);
+    }
+
+    // Reset keeps chip-select routing; re-enable and route one more transaction
+    spi_hw_reset(bus.driver.hw_model);
+    assert(bus.driver.hw_model->slave_respond != NULL);
+    spi_hw_write_reg(bus.driver.hw_model, 0x00, (1U << 6) | (1U << 2));
+    rx[1][0][2] = 0;
+    spi_bus_submit(&bus, ids[1], tx[1][0], rx[1][0], 4);
+    assert(spi_bus_run(&bus) == SPI_OK);
+    assert(rx[1][0][2] == 0x20);
+    spi_bus_deinit(&bus);
+    printf("✓ Multi-slave bus test PASSED\n");
+}
+
+#if SPI_OBSERVERS
+typedef struct {
+    uint32_t calls;
+    uint32_t events;
+    uint32_t last_state;
+    uint8_t bytes[64];
+    bool chain_ok;
+} Test_Observer;
+
+static void test_observe_bytes(void* ctx, const SPI_Event* events, uint32_t count) {
+    Test_Observer* obs = (Test_Observer*)ctx;
+    for (uint32_t i = 0; i < count && obs->events < 64; i++) obs->bytes[obs->events++] = (uint8_t)events[i].value;
+    obs->calls++;
+}
+
+static void test_observe_states(void* ctx, const SPI_Event* events, uint32_t count) {
+    Test_Observer* obs = (Test_Observer*)ctx;
+    for (uint32_t i = 0; i < count; i++) {
+        if (events[i].arg != obs->last_state || events[i].arg == events[i].value) obs->chain_ok = false;
+        obs->last_state = events[i].value;
+    }
+    obs->events += count;
+    obs->calls++;
+}
+#endif
+
+void test_observer_batching(void) {
+    printf("\n=== Test 8: Observer Batching ===\n");
+#if SPI_OBSERVERS
+    SPI_Driver driver;
+    spi_driver_init(&driver, 0x40013000, NULL);
+    SPI_Observer_Hub hub;
+    spi_observer_init(&hub, 0);
+    Test_Observer mosi_a = {0}, mosi_b = {0}, states = {0};
+    states.last_state = SPI_STATE_IDLE;
+    states.chain_ok = true;
+    assert(spi_observer_subscribe(&hub, SPI_EVT_MOSI, test_observe_bytes, &mosi_a));
+    assert(spi_observer_subscribe(&hub, SPI_EVT_MOSI, test_observe_bytes, &mosi_b));
+    assert(spi_observer_subscribe(&hub, SPI_EVT_STATE_CHANGE, test_observe_states, &states));
+    spi_hw_attach_observers(driver.hw_model, &hub);
+
+    // 40 bytes arrive as one full batch plus the remainder at the transfer boundary
+    uint8_t tx[40], rx[40];
+    for (int i = 0; i < 40; i++) tx[i] = (uint8_t)(i * 3);
+    assert(spi_driver_transfer(&driver, tx, rx, 40, 100) == SPI_OK);
+    assert(mosi_a.events == 40 && mosi_b.events == 40);
+    assert(mosi_a.calls == 2);
+    for (int i = 0; i < 40; i++) assert(mosi_a.bytes[i] == tx[i]);
+    // IDLE->TX->RX->IDLE per byte; the final return to IDLE lands after the transfer
+    assert(states.events == 3 * 40 - 1);
+    assert(states.chain_ok);
+
+    // A quantum forces delivery inside a long transfer
+    spi_observer_init(&hub, 1000);
+    Test_Observer quantum = {0}, idle_states = {0};
+    idle_states.last_state = SPI_STATE_RX_ACTIVE;  // Left over from the previous transfer
+    idle_states.chain_ok = true;
+    spi_observer_subscribe(&hub, SPI_EVT_MOSI, test_observe_bytes, &quantum);
+    spi_observer_subscribe(&hub, SPI_EVT_STATE_CHANGE, test_observe_states, &idle_states);
+    spi_hw_attach_observers(driver.hw_model, &hub);
+    assert(spi_driver_transfer(&driver, tx, rx, 20, 100) == SPI_OK);
+    assert(quantum.events == 20);
+    assert(quantum.calls > 2);
+
+    // The trailing ->IDLE change is delivered once the quantum elapses, with no further events
+    assert(idle_states.events == 1 + 3 * 20 - 1);
+    for (int i = 0; i < 1001; i++) spi_hw_clock_cycle(driver.hw_model);
+    assert(idle_states.events == 1 + 3 * 20);
+    assert(idle_states.chain_ok);
+
+    // Reset delivers pending events and keeps the hub attached
+    tx[0] = 0x5A;
+    spi_hw_write_reg(driver.hw_model, 0x0C, tx[0]);
+    for (int i = 0; i < 10; i++) spi_hw_clock_cycle(driver.hw_model);
+    uint32_t before = idle_states.events;
+    spi_hw_reset(driver.hw_model);
+    assert(idle_states.events > before);
+    assert(driver.hw_model->observers == &hub);
+
+    spi_hw_attach_observers(driver.hw_model, NULL);
+    spi_driver_deinit(&driver);
+    printf("✓ Observer batching test PASSED\n");
+#else
+    printf("Observers compiled out (SPI_OBSERVERS=0), skipped\n");
+#endif
+}